@@ -9,29 +9,55 @@
 
 class Display {
 private:
+    // Path cells bucketed by maze row, each row kept in path order.
+    struct PathIndex {
+        std::vector<int> rowStart;
+        std::vector<std::pair<int, int>> cells; // column, position in path
+
+        void build(const std::vector<std::pair<int, int>>& path, int height);
+    };
+
     int termsize[2];
     int offsetX;
     int offsetY;
+    int zoomLevel;
     bool needsRedraw;
     bool resizeNeeded;
     std::chrono::steady_clock::time_point lastResizeTime;
     std::unordered_map<std::string, int> colorMap;
+    PathIndex explorationIndex;
+    PathIndex solutionIndex;
+    int indexedPathVersion;
+    std::vector<unsigned char> minimapDots;
+    int minimapVersion;
+    int minimapCellsPerDot;
 
     void setupColors();
     int getVisualWidth(const std::string& str);
     std::string colorTags(const std::string& str);
+    void updatePathIndex(const MazeGenerator& maze);
+    void overlayRow(const MazeGenerator& maze, int row, int firstCol, int lastCol, unsigned char* states);
+    void getZoomScale(int zoom, int& scaleY, int& scaleX) const;
+    void getScaledSize(const MazeGenerator& maze, int& rows, int& cols) const;
+    void drawZoomedMaze(const MazeGenerator& maze);
+    void updateMinimapDots(const MazeGenerator& maze, int cellsPerDot);
+    void drawMinimap(const MazeGenerator& maze);
+    void drawGlyphs(int y, int x, int rows, int cols, int zoom,
+                    const std::vector<unsigned char>& masks, const std::vector<unsigned char>& colors);
 
 public:
     Display();
     ~Display();
 
     void setup();
+    void setupHeadless(int rows, int cols);
     void updateTermsize();
     void checkResize();
     void centerPrint(const std::string& str, bool vertical, int y);
     void drawMaze(const MazeGenerator& maze);
     void drawUI();
     void validPositionHint(const MazeGenerator& maze);
+    void cycleZoom();
     void redraw(const MazeGenerator& maze);
 
     int getOffsetX() const;
@@ -13,22 +13,42 @@ private:
     int width;
     int height;
     std::vector<std::vector<char>> grid;
+    std::vector<unsigned char> costs;
     std::vector<std::pair<int, int>> solutionPath;
     std::vector<std::pair<int, int>> explorationPath;
     std::mt19937 gen;
     bool solving;
     int solvingStep;
     static const int solvingAnimationDelay = 20;
+    static const int terrainScale = 8;
+    static const int loopChance = 8;
     std::chrono::steady_clock::time_point lastStepTime;
     bool explorationComplete;
+    int pathVersion;
+    bool terrainEnabled;
+    int pathCost;
 
     int randomInt(int lower, int upper);
+    void openLoops();
+    void generateTerrain();
+    bool findShortestPath();
+    bool findWeightedPath();
 
 public:
+    static constexpr int maxTerrainCost = 9;
+    static constexpr int minMazeSide = 5;
+    static constexpr int maxMazeSide = 20001;
+
     MazeGenerator();
+    static bool isValidSide(int side);
     void setSeed(unsigned int seed);
     void generate(int w, int h);
+    void setTerrainEnabled(bool enabled);
+    bool hasTerrain() const;
+    int getCost(int y, int x) const;
     void startSolving();
+    bool solve(bool weighted);
+    int getPathCost() const;
     bool isSolving() const;
     bool solveStep();
     const std::vector<std::vector<char>>& getGrid() const;
@@ -36,6 +56,7 @@ public:
     const std::vector<std::pair<int, int>>& getExplorationPath() const;
     int getSolvingStep() const;
     bool isExplorationComplete() const;
+    int getPathVersion() const;
     int getWidth() const;
     int getHeight() const;
     void updateCell(int y, int x, char c);
@@ -0,0 +1,135 @@
+#ifndef MAZESERVER_HPP
+#define MAZESERVER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <sys/types.h>
+#include "mazeGenerator.hpp"
+
+class MazeServer {
+private:
+    struct MazeRequest {
+        std::string algorithm;
+        int width;
+        int height;
+        unsigned int seed;
+        bool solve;
+    };
+
+    struct CacheEntry {
+        int fd;
+        size_t size;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    // Work handed to the worker pool: either rendering a maze into a memfd or
+    // copying an evicted memfd into the spill directory.
+    struct Job {
+        std::string key;
+        MazeRequest request;
+        bool spill;
+        int fd;
+        size_t size;
+        size_t cost;
+        bool ok;
+        std::string error;
+    };
+
+    // A response owns its own descriptor, so evicting the cache entry it was
+    // served from never cuts a transfer short.
+    struct Response {
+        std::string key;
+        std::string header;
+        size_t headerSent;
+        int fd;
+        off_t offset;
+        size_t size;
+    };
+
+    struct Client {
+        std::string input;
+        std::deque<Response> responses;
+        unsigned int interest;
+        bool eof;
+    };
+
+    // Served mazes may be at most half as wide and tall as the generator
+    // allows, which keeps one solved request to a few gigabytes.
+    static constexpr int maxServedSide = MazeGenerator::maxMazeSide / 2 + 1;
+    static const size_t maxRequestLine = 256;
+    // Requests beyond this many unanswered ones stay unparsed in the input
+    // buffer until earlier responses have been sent.
+    static const size_t maxPipelined = 1024;
+    // Rough peak memory of one job per maze cell, used to bound how much
+    // generation runs at once.
+    static const size_t generateBytesPerCell = 6;
+    static const size_t solveBytesPerCell = 28;
+
+    std::string socketPath;
+    std::string spillDir;
+    size_t cacheLimit;
+    size_t cacheSize;
+    size_t spillLimit;
+    size_t spillSize;
+    int listenFd;
+    int epollFd;
+    int eventFd;
+    std::unordered_map<int, Client> clients;
+    std::unordered_map<std::string, CacheEntry> cache;
+    std::list<std::string> lru;
+    std::unordered_map<std::string, CacheEntry> spilled;
+    std::list<std::string> spillLru;
+    std::unordered_map<std::string, CacheEntry> spilling;
+
+    std::unordered_set<std::string> queuedKeys;
+    // Responses still waiting for a key to be generated. Deque elements keep
+    // their address while the owning client pushes and pops around them.
+    std::unordered_map<std::string, std::vector<Response*>> waiters;
+    std::deque<Job> waitingJobs;
+    size_t inFlightJobs;
+    size_t inFlightBytes;
+
+    std::vector<std::thread> workers;
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<Job> jobQueue;
+    std::vector<Job> doneJobs;
+    bool stopping;
+
+    bool parseRequest(const std::string& line, MazeRequest& request, std::string& error) const;
+    std::string cacheKey(const MazeRequest& request) const;
+    std::string spillPath(const std::string& key) const;
+    int lookup(const std::string& key, size_t& size);
+    void insert(const std::string& key, int fd, size_t size);
+    void evict();
+    void addSpilled(const std::string& key, size_t size);
+    void trimSpill();
+    bool loadSpillDir();
+    void queueGeneration(const std::string& key, const MazeRequest& request);
+    void submitJobs();
+    void pushJob(Job job);
+    void workerLoop();
+    void processCompletions();
+    bool resolve(Response& response);
+    void acceptClients();
+    void parseLine(const std::string& line, Client& client);
+    bool parseInput(Client& client);
+    bool readClient(int fd, Client& client);
+    bool flushClient(int fd, Client& client);
+    void updateInterest(int fd, Client& client);
+    void closeClient(int fd);
+
+public:
+    MazeServer(const std::string& socketPath, size_t cacheLimit, const std::string& spillDir, size_t spillLimit);
+    ~MazeServer();
+    int run();
+};
+
+#endif
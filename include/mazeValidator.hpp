@@ -0,0 +1,35 @@
+#ifndef MAZEVALIDATOR_HPP
+#define MAZEVALIDATOR_HPP
+
+#include <vector>
+#include "mazeGenerator.hpp"
+
+class MazeValidator {
+private:
+    int width;
+    int height;
+    int threadCount;
+    std::vector<int> parent;
+    long long openCells;
+    long long edgeCount;
+    long long mergeCount;
+    bool endpointsOpen;
+
+    int findRoot(int cell);
+    bool unite(int a, int b);
+    void validateBlock(const std::vector<std::vector<char>>& grid, int firstRow, int lastRow,
+                       long long& open, long long& edges, long long& merges);
+
+public:
+    MazeValidator();
+    void setThreadCount(int count);
+    bool validate(const MazeGenerator& maze);
+    bool isPerfect() const;
+    bool hasCycle() const;
+    bool areEndpointsOpen() const;
+    long long getOpenCells() const;
+    long long getEdgeCount() const;
+    long long getComponentCount() const;
+};
+
+#endif
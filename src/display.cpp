@@ -5,11 +5,46 @@
 #include <locale.h>
 #include <wchar.h>
 #include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
 
 extern void signalHandler(int);
 extern void resizeHandler(int);
 
-Display::Display() : offsetX(0), offsetY(0), needsRedraw(true), resizeNeeded(false) {
+// Dot bit for each cell of a glyph, indexed [row][col] within the glyph.
+static const unsigned char halfBlockBits[4][2] = {{0x01, 0}, {0x02, 0}, {0, 0}, {0, 0}};
+static const unsigned char brailleBits[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+
+// Open cells shaded from cheapest to most expensive terrain.
+static const char* terrainShades[4] = {" ", "░", "▒", "▓"};
+
+// ORs one maze row into a row of glyph masks. Kept branchless over a flat
+// char array so the compiler can vectorize it.
+template <int ScaleX>
+static void reduceRow(const char* cells, unsigned char* masks, int count, unsigned char bitLeft, unsigned char bitRight) {
+    for (int i = 0; i < count; i++) {
+        unsigned char mask = (cells[i * ScaleX] == '#') * bitLeft;
+        if (ScaleX == 2) {
+            mask |= (cells[i * ScaleX + 1] == '#') * bitRight;
+        }
+        masks[i] |= mask;
+    }
+}
+
+static void appendGlyph(std::string& out, int zoom, unsigned char mask) {
+    static const char* halfBlocks[4] = {" ", "▀", "▄", "█"};
+    if (zoom == 1) {
+        out += halfBlocks[mask & 0x03];
+    } else {
+        // U+2800 + mask encoded as UTF-8
+        out.push_back(static_cast<char>(0xE2));
+        out.push_back(static_cast<char>(0xA0 | (mask >> 6)));
+        out.push_back(static_cast<char>(0x80 | (mask & 0x3F)));
+    }
+}
+
+Display::Display() : offsetX(0), offsetY(0), zoomLevel(0), needsRedraw(true), resizeNeeded(false), indexedPathVersion(-1),
+                     minimapVersion(-1), minimapCellsPerDot(0) {
     termsize[0] = 0;
     termsize[1] = 0;
     lastResizeTime = std::chrono::steady_clock::now();
@@ -59,6 +94,20 @@ void Display::setup() {
     updateTermsize();
 }
 
+// Renders into /dev/null at a fixed size, for timing frames without a terminal.
+void Display::setupHeadless(int rows, int cols) {
+    setlocale(LC_ALL, "en_US.UTF-8");
+    FILE* devNull = fopen("/dev/null", "w");
+    const char* term = getenv("TERM");
+    if (!devNull || !newterm(term && *term ? term : "xterm", devNull, stdin)) {
+        throw std::runtime_error("cannot create a headless screen");
+    }
+    resizeterm(rows, cols);
+
+    setupColors();
+    updateTermsize();
+}
+
 void Display::updateTermsize() {
     getmaxyx(stdscr, termsize[0], termsize[1]);
     termsize[0]--;
@@ -180,6 +229,78 @@ void Display::centerPrint(const std::string& str, bool vertical, int y) {
     }
 }
 
+void Display::getZoomScale(int zoom, int& scaleY, int& scaleX) const {
+    switch (zoom) {
+        case 1:
+            scaleY = 2;
+            scaleX = 1;
+            break;
+        case 2:
+            scaleY = 4;
+            scaleX = 2;
+            break;
+        default:
+            scaleY = 1;
+            scaleX = 1;
+            break;
+    }
+}
+
+void Display::getScaledSize(const MazeGenerator& maze, int& rows, int& cols) const {
+    int scaleY, scaleX;
+    getZoomScale(zoomLevel, scaleY, scaleX);
+    rows = (maze.getHeight() + scaleY - 1) / scaleY;
+    cols = (maze.getWidth() + scaleX - 1) / scaleX;
+}
+
+void Display::PathIndex::build(const std::vector<std::pair<int, int>>& path, int height) {
+    rowStart.assign(height + 1, 0);
+    for (const auto& cell : path) {
+        rowStart[cell.first + 1]++;
+    }
+    for (int row = 0; row < height; row++) {
+        rowStart[row + 1] += rowStart[row];
+    }
+
+    cells.resize(path.size());
+    std::vector<int> fill(rowStart.begin(), rowStart.end() - 1);
+    for (int i = 0; i < static_cast<int>(path.size()); i++) {
+        cells[fill[path[i].first]++] = {path[i].second, i};
+    }
+}
+
+void Display::updatePathIndex(const MazeGenerator& maze) {
+    if (indexedPathVersion == maze.getPathVersion()) return;
+
+    indexedPathVersion = maze.getPathVersion();
+    explorationIndex.build(maze.getExplorationPath(), maze.getHeight());
+    solutionIndex.build(maze.getSolutionPath(), maze.getHeight());
+}
+
+void Display::overlayRow(const MazeGenerator& maze, int row, int firstCol, int lastCol, unsigned char* states) {
+    int step = maze.getSolvingStep();
+    bool explorationComplete = maze.isExplorationComplete();
+    int exploredLimit = explorationComplete ? static_cast<int>(explorationIndex.cells.size()) : step;
+
+    for (int i = explorationIndex.rowStart[row]; i < explorationIndex.rowStart[row + 1]; i++) {
+        const auto& cell = explorationIndex.cells[i];
+        if (cell.second >= exploredLimit) break;
+        if (cell.first >= firstCol && cell.first < lastCol) {
+            states[cell.first - firstCol] = 3;
+        }
+    }
+
+    if (!explorationComplete) return;
+
+    for (int i = solutionIndex.rowStart[row]; i < solutionIndex.rowStart[row + 1]; i++) {
+        const auto& cell = solutionIndex.cells[i];
+        if (cell.second >= step) break;
+        if (cell.first >= firstCol && cell.first < lastCol) {
+            states[cell.first - firstCol] = 2;
+        }
+    }
+}
+
 void Display::drawMaze(const MazeGenerator& maze) {
     int mazeWidth = maze.getWidth();
     int mazeHeight = maze.getHeight();
@@ -188,61 +309,56 @@ void Display::drawMaze(const MazeGenerator& maze) {
         return;
     }
 
-    const auto& grid = maze.getGrid();
-    const auto& solutionPath = maze.getSolutionPath();
-    const auto& explorationPath = maze.getExplorationPath();
+    if (zoomLevel > 0) {
+        drawZoomedMaze(maze);
+        return;
+    }
 
-    int startY = termsize[0] / 2 - mazeHeight / 2;
-    int startX = termsize[1] / 2 - mazeWidth / 2;
+    const auto& grid = maze.getGrid();
+    bool showTerrain = maze.hasTerrain();
+    bool showOverlay = maze.isSolving() || !maze.getSolutionPath().empty();
+    if (showOverlay) {
+        updatePathIndex(maze);
+    }
 
-    int step = maze.getSolvingStep();
-    bool explorationComplete = maze.isExplorationComplete();
+    int startY = termsize[0] / 2 - mazeHeight / 2 + offsetY;
+    int startX = termsize[1] / 2 - mazeWidth / 2 + offsetX;
 
-    for (int row = 0; row < mazeHeight; row++) {
-        for (int col = 0; col < mazeWidth; col++) {
-            int yPos = startY + row + offsetY;
-            int xPos = startX + col + offsetX;
+    int firstRow = std::max(0, -startY);
+    int lastRow = std::min(mazeHeight, termsize[0] - startY);
+    int firstCol = std::max(0, -startX);
+    int lastCol = std::min(mazeWidth, termsize[1] - startX);
 
-            if (yPos < 0 || yPos >= termsize[0] || xPos < 0 || xPos >= termsize[1]) {
-                continue;
-            }
+    if (firstRow >= lastRow || firstCol >= lastCol) {
+        return;
+    }
 
-            bool isOnPath = false;
-            bool isExplored = false;
+    std::vector<unsigned char> states(lastCol - firstCol);
 
-            if (maze.isSolving() || !solutionPath.empty()) {
-                if (!explorationComplete) {
-                    for (int i = 0; i < step && i < static_cast<int>(explorationPath.size()); i++) {
-                        if (explorationPath[i].first == row && explorationPath[i].second == col) {
-                            isExplored = true;
-                            break;
-                        }
-                    }
-                } else {
-                    for (const auto& cell : explorationPath) {
-                        if (cell.first == row && cell.second == col) {
-                            isExplored = true;
-                            break;
-                        }
-                    }
+    for (int row = firstRow; row < lastRow; row++) {
+        std::fill(states.begin(), states.end(), 0);
+        if (showOverlay) {
+            overlayRow(maze, row, firstCol, lastCol, states.data());
+        }
 
-                    for (int i = 0; i < step && i < static_cast<int>(solutionPath.size()); i++) {
-                        if (solutionPath[i].first == row && solutionPath[i].second == col) {
-                            isOnPath = true;
-                            break;
-                        }
-                    }
-                }
-            }
+        for (int col = firstCol; col < lastCol; col++) {
+            int yPos = startY + row;
+            int xPos = startX + col;
 
-            if (isOnPath) {
+            unsigned char state = states[col - firstCol];
+            if (state == 2) {
                 attron(COLOR_PAIR(2));
                 mvaddch(yPos, xPos, '.');
                 attroff(COLOR_PAIR(2));
-            } else if (isExplored) {
+            } else if (state == 3) {
                 attron(COLOR_PAIR(3));
                 mvaddch(yPos, xPos, '*');
                 attroff(COLOR_PAIR(3));
+            } else if (showTerrain && grid[row][col] == ' ') {
+                int shade = (maze.getCost(row, col) - 1) * 4 / MazeGenerator::maxTerrainCost;
+                attron(COLOR_PAIR(5));
+                mvaddstr(yPos, xPos, terrainShades[shade]);
+                attroff(COLOR_PAIR(5));
             } else {
                 mvaddch(yPos, xPos, grid[row][col]);
             }
@@ -250,15 +366,228 @@ void Display::drawMaze(const MazeGenerator& maze) {
     }
 }
 
+void Display::drawGlyphs(int y, int x, int rows, int cols, int zoom,
+                         const std::vector<unsigned char>& masks, const std::vector<unsigned char>& colors) {
+    std::string line;
+    for (int gy = 0; gy < rows; gy++) {
+        int gx = 0;
+        while (gx < cols) {
+            int runStart = gx;
+            unsigned char color = colors[gy * cols + gx];
+            line.clear();
+            while (gx < cols && colors[gy * cols + gx] == color) {
+                appendGlyph(line, zoom, masks[gy * cols + gx]);
+                gx++;
+            }
+
+            if (color > 1) attron(COLOR_PAIR(color));
+            mvaddstr(y + gy, x + runStart, line.c_str());
+            if (color > 1) attroff(COLOR_PAIR(color));
+        }
+    }
+}
+
+// Glyphs only show walls and the solving overlay; terrain shading needs a
+// whole character per cell and is drawn at 1:1 only.
+void Display::drawZoomedMaze(const MazeGenerator& maze) {
+    int mazeWidth = maze.getWidth();
+    int mazeHeight = maze.getHeight();
+
+    int scaleY, scaleX;
+    getZoomScale(zoomLevel, scaleY, scaleX);
+    int glyphRows, glyphCols;
+    getScaledSize(maze, glyphRows, glyphCols);
+
+    int startY = termsize[0] / 2 - glyphRows / 2 + offsetY;
+    int startX = termsize[1] / 2 - glyphCols / 2 + offsetX;
+
+    int firstRow = std::max(0, -startY);
+    int lastRow = std::min(glyphRows, termsize[0] - startY);
+    int firstCol = std::max(0, -startX);
+    int lastCol = std::min(glyphCols, termsize[1] - startX);
+
+    if (firstRow >= lastRow || firstCol >= lastCol) {
+        return;
+    }
+
+    int visibleRows = lastRow - firstRow;
+    int visibleCols = lastCol - firstCol;
+    std::vector<unsigned char> masks(visibleRows * visibleCols, 0);
+    std::vector<unsigned char> colors(visibleRows * visibleCols, 1);
+
+    const auto& grid = maze.getGrid();
+    const unsigned char (*bits)[2] = zoomLevel == 1 ? halfBlockBits : brailleBits;
+
+    // Only glyphs whose cells all lie inside the maze go through the fast path,
+    // the ragged last column (odd widths) is handled per cell.
+    int fullCols = std::min(visibleCols, (mazeWidth - firstCol * scaleX) / scaleX);
+
+    for (int gy = 0; gy < visibleRows; gy++) {
+        unsigned char* rowMasks = &masks[gy * visibleCols];
+        for (int r = 0; r < scaleY; r++) {
+            int row = (firstRow + gy) * scaleY + r;
+            if (row >= mazeHeight) break;
+
+            const char* cells = grid[row].data() + firstCol * scaleX;
+            if (scaleX == 1) {
+                reduceRow<1>(cells, rowMasks, fullCols, bits[r][0], 0);
+            } else {
+                reduceRow<2>(cells, rowMasks, fullCols, bits[r][0], bits[r][1]);
+            }
+
+            for (int gx = fullCols; gx < visibleCols; gx++) {
+                for (int c = 0; c < scaleX; c++) {
+                    int col = (firstCol + gx) * scaleX + c;
+                    if (col < mazeWidth && grid[row][col] == '#') {
+                        rowMasks[gx] |= bits[r][c];
+                    }
+                }
+            }
+        }
+    }
+
+    if (maze.isSolving() || !maze.getSolutionPath().empty()) {
+        updatePathIndex(maze);
+
+        int firstCell = firstCol * scaleX;
+        int lastCell = std::min(mazeWidth, lastCol * scaleX);
+        std::vector<unsigned char> states(lastCell - firstCell);
+
+        for (int row = firstRow * scaleY; row < std::min(mazeHeight, lastRow * scaleY); row++) {
+            std::fill(states.begin(), states.end(), 0);
+            overlayRow(maze, row, firstCell, lastCell, states.data());
+
+            unsigned char* rowMasks = &masks[(row / scaleY - firstRow) * visibleCols];
+            unsigned char* rowColors = &colors[(row / scaleY - firstRow) * visibleCols];
+            for (int i = 0; i < lastCell - firstCell; i++) {
+                unsigned char state = states[i];
+                if (state == 0) continue;
+
+                int col = firstCell + i;
+                int gx = col / scaleX - firstCol;
+                if (state == 2) {
+                    rowMasks[gx] |= bits[row % scaleY][col % scaleX];
+                    rowColors[gx] = 2;
+                } else if (rowColors[gx] != 2) {
+                    rowColors[gx] = 3;
+                }
+            }
+        }
+    }
+
+    drawGlyphs(startY + firstRow, startX + firstCol, visibleRows, visibleCols, zoomLevel, masks, colors);
+}
+
+void Display::updateMinimapDots(const MazeGenerator& maze, int cellsPerDot) {
+    if (minimapVersion == maze.getPathVersion() && minimapCellsPerDot == cellsPerDot) return;
+
+    minimapVersion = maze.getPathVersion();
+    minimapCellsPerDot = cellsPerDot;
+
+    int mazeWidth = maze.getWidth();
+    int mazeHeight = maze.getHeight();
+    int dotRows = (mazeHeight + cellsPerDot - 1) / cellsPerDot;
+    int dotCols = (mazeWidth + cellsPerDot - 1) / cellsPerDot;
+    const auto& grid = maze.getGrid();
+
+    // A dot is set when walls fill the majority of its block. Sampling a
+    // single cell per block aliases against the maze's two-cell lattice.
+    minimapDots.assign(dotRows * dotCols, 0);
+    std::vector<int> walls(dotCols);
+
+    for (int dy = 0; dy < dotRows; dy++) {
+        std::fill(walls.begin(), walls.end(), 0);
+        int firstRow = dy * cellsPerDot;
+        int lastRow = std::min(mazeHeight, firstRow + cellsPerDot);
+
+        for (int row = firstRow; row < lastRow; row++) {
+            const char* cells = grid[row].data();
+            for (int dx = 0; dx < dotCols; dx++) {
+                int firstCol = dx * cellsPerDot;
+                int lastCol = std::min(mazeWidth, firstCol + cellsPerDot);
+                int count = 0;
+                for (int col = firstCol; col < lastCol; col++) {
+                    count += cells[col] == '#';
+                }
+                walls[dx] += count;
+            }
+        }
+
+        for (int dx = 0; dx < dotCols; dx++) {
+            int blockCells = (lastRow - firstRow) * (std::min(mazeWidth, (dx + 1) * cellsPerDot) - dx * cellsPerDot);
+            minimapDots[dy * dotCols + dx] = walls[dx] * 2 > blockCells;
+        }
+    }
+}
+
+void Display::drawMinimap(const MazeGenerator& maze) {
+    int mazeWidth = maze.getWidth();
+    int mazeHeight = maze.getHeight();
+
+    int glyphRows, glyphCols;
+    getScaledSize(maze, glyphRows, glyphCols);
+
+    if (mazeWidth <= 0 || mazeHeight <= 0 || (glyphRows <= termsize[0] && glyphCols <= termsize[1])) {
+        return;
+    }
+
+    int maxRows = std::min(8, termsize[0] / 4);
+    int maxCols = std::min(24, termsize[1] / 4);
+    if (maxRows <= 0 || maxCols <= 0) {
+        return;
+    }
+
+    int cellsPerDot = std::max((mazeHeight + maxRows * 4 - 1) / (maxRows * 4),
+                               (mazeWidth + maxCols * 2 - 1) / (maxCols * 2));
+    int dotRows = (mazeHeight + cellsPerDot - 1) / cellsPerDot;
+    int dotCols = (mazeWidth + cellsPerDot - 1) / cellsPerDot;
+    int mapRows = (dotRows + 3) / 4;
+    int mapCols = (dotCols + 1) / 2;
+
+    int scaleY, scaleX;
+    getZoomScale(zoomLevel, scaleY, scaleX);
+    int startY = termsize[0] / 2 - glyphRows / 2 + offsetY;
+    int startX = termsize[1] / 2 - glyphCols / 2 + offsetX;
+
+    int viewTop = std::max(0, -startY) * scaleY / cellsPerDot;
+    int viewBottom = (std::min(mazeHeight, (termsize[0] - startY) * scaleY) - 1) / cellsPerDot;
+    int viewLeft = std::max(0, -startX) * scaleX / cellsPerDot;
+    int viewRight = (std::min(mazeWidth, (termsize[1] - startX) * scaleX) - 1) / cellsPerDot;
+    bool viewVisible = viewTop <= viewBottom && viewLeft <= viewRight;
+
+    updateMinimapDots(maze, cellsPerDot);
+
+    std::vector<unsigned char> masks(mapRows * mapCols, 0);
+    std::vector<unsigned char> colors(mapRows * mapCols, 3);
+
+    for (int dy = 0; dy < dotRows; dy++) {
+        for (int dx = 0; dx < dotCols; dx++) {
+            int index = (dy / 4) * mapCols + dx / 2;
+
+            bool inView = viewVisible && dy >= viewTop && dy <= viewBottom && dx >= viewLeft && dx <= viewRight;
+            bool onEdge = inView && (dy == viewTop || dy == viewBottom || dx == viewLeft || dx == viewRight);
+
+            if (minimapDots[dy * dotCols + dx] || onEdge) {
+                masks[index] |= brailleBits[dy % 4][dx % 2];
+            }
+            if (inView) {
+                colors[index] = 2;
+            }
+        }
+    }
+
+    drawGlyphs(1, termsize[1] - mapCols, mapRows, mapCols, 2, masks, colors);
+}
+
 void Display::drawUI() {
-    centerPrint("/red/↑→↓←/white/ - /gray/Move  /red/S/white/ - /gray/Solve /red/R/white/ - /gray/Regenerate  /red/M/white/ - /gray/Menu/white/  /red/Q/white/ - /gray/Quit/red/", false, termsize[0] - 1);
+    centerPrint("/red/↑→↓←/white/ - /gray/Move  /red/S/white/ - /gray/Solve  /red/R/white/ - /gray/New  /red/Z/white/ - /gray/Zoom  /red/T/white/ - /gray/Terrain  /red/M/white/ - /gray/Menu/white/  /red/Q/white/ - /gray/Quit/red/", false, termsize[0] - 1);
     centerPrint("/gray/Maze Generator/white/", false, 0);
     centerPrint("/green/seed/white/: /white/[/gray/XXXX-XXXX/white/] ", false, termsize[0] - 3);
 }
 
 void Display::validPositionHint(const MazeGenerator& maze) {
-    int mazeWidth = maze.getWidth();
-    int mazeHeight = maze.getHeight();
+    int mazeHeight, mazeWidth;
+    getScaledSize(maze, mazeHeight, mazeWidth);
 
     int positionUp = termsize[0] / 2 - mazeHeight / 2 + offsetY;
     int positionDown = termsize[0] / 2 + mazeHeight / 2 + offsetY;
@@ -280,9 +609,21 @@ void Display::redraw(const MazeGenerator& maze) {
     drawMaze(maze);
     drawUI();
     validPositionHint(maze);
+    drawMinimap(maze);
     refresh();
 }
 
+void Display::cycleZoom() {
+    int oldScaleY, oldScaleX, newScaleY, newScaleX;
+    getZoomScale(zoomLevel, oldScaleY, oldScaleX);
+    zoomLevel = (zoomLevel + 1) % 3;
+    getZoomScale(zoomLevel, newScaleY, newScaleX);
+
+    offsetY = offsetY * oldScaleY / newScaleY;
+    offsetX = offsetX * oldScaleX / newScaleX;
+    needsRedraw = true;
+}
+
 int Display::getOffsetX() const {
     return offsetX;
 }
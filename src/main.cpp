@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <ncurses.h>
 #include <random>
@@ -7,6 +10,8 @@
 #include <thread>
 #include "../include/mazeGenerator.hpp"
 #include "../include/display.hpp"
+#include "../include/mazeServer.hpp"
+#include "../include/mazeValidator.hpp"
 
 bool resizeNeeded = false;
 MazeGenerator* globalMazePtr = nullptr;
@@ -27,7 +32,25 @@ void resizeHandler(int) {
     }
 }
 
-void mainLoop(Display& display, MazeGenerator& maze) {
+int parseMazeSide(const char* arg) {
+    int side = std::stoi(arg);
+    if (!MazeGenerator::isValidSide(side)) {
+        throw std::out_of_range("maze side must be odd and in range");
+    }
+    return side;
+}
+
+// Cells are carved on odd coordinates, so an even side would wall off the
+// exit. Round it up to the next odd value instead.
+int parseRoundedMazeSide(const char* arg) {
+    int side = std::stoi(arg) | 1;
+    if (!MazeGenerator::isValidSide(side)) {
+        throw std::out_of_range("maze side out of range");
+    }
+    return side;
+}
+
+void mainLoop(Display& display, MazeGenerator& maze, int mazeWidth, int mazeHeight) {
     auto lastFrameTime = std::chrono::steady_clock::now();
     const int targetFrameTimeMs = 10;
 
@@ -61,10 +84,17 @@ void mainLoop(Display& display, MazeGenerator& maze) {
             maze.startSolving();
             display.setNeedsRedraw(true);
         }
+        if (ch == 'z' || ch == 'Z') {
+            display.cycleZoom();
+        }
+        if (ch == 't' || ch == 'T') {
+            maze.setTerrainEnabled(!maze.hasTerrain());
+            display.setNeedsRedraw(true);
+        }
         if (ch == 'r' || ch == 'R') {
             std::random_device rd;
             maze.setSeed(rd());
-            maze.generate(41, 21);
+            maze.generate(mazeWidth, mazeHeight);
             display.setNeedsRedraw(true);
         }
 
@@ -95,7 +125,192 @@ void mainLoop(Display& display, MazeGenerator& maze) {
     }
 }
 
-int main() {
+int runValidationBatch(int count, int width, int height) {
+    MazeGenerator maze;
+    MazeValidator validator;
+    std::random_device rd;
+
+    std::chrono::steady_clock::duration generationTime{};
+    std::chrono::steady_clock::duration validationTime{};
+    int failures = 0;
+
+    for (int i = 0; i < count; i++) {
+        unsigned int seed = rd();
+        maze.setSeed(seed);
+
+        auto generationStart = std::chrono::steady_clock::now();
+        maze.generate(width, height);
+        auto validationStart = std::chrono::steady_clock::now();
+        bool perfect = validator.validate(maze);
+        auto validationEnd = std::chrono::steady_clock::now();
+
+        generationTime += validationStart - generationStart;
+        validationTime += validationEnd - validationStart;
+
+        if (!perfect) {
+            failures++;
+            std::cout << "seed " << seed << ": not perfect ("
+                      << "components " << validator.getComponentCount()
+                      << ", edges " << validator.getEdgeCount()
+                      << ", open cells " << validator.getOpenCells()
+                      << (validator.hasCycle() ? ", has cycle" : "")
+                      << (validator.areEndpointsOpen() ? "" : ", endpoints closed") << ")" << std::endl;
+        }
+    }
+
+    auto toMs = [](std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+    std::cout << count - failures << "/" << count << " mazes perfect ("
+              << width << "x" << height << "), generation " << toMs(generationTime)
+              << " ms, validation " << toMs(validationTime) << " ms" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
+
+int runSolverBenchmark(int width, int height, int runs) {
+    MazeGenerator maze;
+    std::random_device rd;
+    maze.setSeed(rd());
+    maze.generate(width, height);
+    maze.setTerrainEnabled(true);
+
+    auto benchmark = [&](const char* name, bool weighted) {
+        double totalMs = 0;
+        for (int i = 0; i < runs; i++) {
+            auto start = std::chrono::steady_clock::now();
+            maze.solve(weighted);
+            totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        double averageMs = totalMs / runs;
+        double cellsPerSecond = maze.getExplorationPath().size() / (averageMs / 1000.0);
+        std::cout << name << ": " << averageMs << " ms, " << maze.getExplorationPath().size()
+                  << " cells explored (" << cellsPerSecond / 1e6 << " M cells/s), path length "
+                  << maze.getSolutionPath().size() << ", terrain cost " << maze.getPathCost() << std::endl;
+    };
+
+    std::cout << width << "x" << height << " maze, " << runs << " runs" << std::endl;
+    benchmark("bfs     ", false);
+    benchmark("dijkstra", true);
+
+    return 0;
+}
+
+int runRenderBenchmark(int width, int height, int frames) {
+    const int screenRows = 50;
+    const int screenCols = 160;
+
+    MazeGenerator maze;
+    std::random_device rd;
+    maze.setSeed(rd());
+    maze.generate(width, height);
+
+    auto solveStart = std::chrono::steady_clock::now();
+    maze.solve(false);
+    double solveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - solveStart).count();
+
+    std::vector<std::string> results;
+    try {
+        Display display;
+        display.setupHeadless(screenRows, screenCols);
+
+        for (int zoom = 0; zoom < 3; zoom++) {
+            auto firstStart = std::chrono::steady_clock::now();
+            display.redraw(maze);
+            auto firstEnd = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; i++) {
+                display.redraw(maze);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            double firstMs = std::chrono::duration<double, std::milli>(firstEnd - firstStart).count();
+            double frameMs = std::chrono::duration<double, std::milli>(end - firstEnd).count() / frames;
+            results.push_back("zoom " + std::to_string(zoom) + ": first frame " + std::to_string(firstMs) +
+                              " ms, then " + std::to_string(frameMs) + " ms/frame");
+            display.cycleZoom();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Render benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << width << "x" << height << " maze on a " << screenCols << "x" << screenRows
+              << " screen, solved in " << solveMs << " ms (" << maze.getExplorationPath().size()
+              << " cells explored), " << frames << " frames per zoom level" << std::endl;
+    for (const auto& result : results) {
+        std::cout << result << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench-render") {
+        try {
+            int width = argc > 2 ? parseRoundedMazeSide(argv[2]) : 10001;
+            int height = argc > 3 ? parseRoundedMazeSide(argv[3]) : 10001;
+            int frames = argc > 4 ? std::max(1, std::stoi(argv[4])) : 20;
+            return runRenderBenchmark(width, height, frames);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Usage: mazegen --bench-render [width] [height] [frames]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        try {
+            if (argc < 3) throw std::invalid_argument("missing socket path");
+            size_t cacheMb = argc > 3 ? std::stoul(argv[3]) : 256;
+            std::string spillDir = argc > 4 ? argv[4] : "";
+            size_t spillMb = argc > 5 ? std::stoul(argv[5]) : 4 * cacheMb;
+            MazeServer server(argv[2], cacheMb * 1024 * 1024, spillDir, spillMb * 1024 * 1024);
+            return server.run();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Usage: mazegen --serve <socket> [cache MB] [spill dir] [spill MB]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        try {
+            int width = argc > 2 ? parseMazeSide(argv[2]) : 1001;
+            int height = argc > 3 ? parseMazeSide(argv[3]) : 1001;
+            int runs = argc > 4 ? std::max(1, std::stoi(argv[4])) : 5;
+            return runSolverBenchmark(width, height, runs);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Usage: mazegen --bench [width] [height] [runs]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--validate") {
+        try {
+            int count = argc > 2 ? std::max(1, std::stoi(argv[2])) : 1;
+            int width = argc > 3 ? parseMazeSide(argv[3]) : 41;
+            int height = argc > 4 ? parseMazeSide(argv[4]) : 21;
+            return runValidationBatch(count, width, height);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Usage: mazegen --validate [count] [width] [height]" << std::endl;
+            return 1;
+        }
+    }
+
+    int mazeWidth = 41;
+    int mazeHeight = 21;
+    try {
+        if (argc > 1) mazeWidth = parseRoundedMazeSide(argv[1]);
+        if (argc > 2) mazeHeight = parseRoundedMazeSide(argv[2]);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Usage: mazegen [width] [height]" << std::endl;
+        return 1;
+    }
+
     try {
         Display display;
         MazeGenerator maze;
@@ -111,9 +326,9 @@ int main() {
 
         std::random_device rd;
         maze.setSeed(rd());
-        maze.generate(41, 21);
+        maze.generate(mazeWidth, mazeHeight);
 
-        mainLoop(display, maze);
+        mainLoop(display, maze, mazeWidth, mazeHeight);
 
         endwin();
         return 0;
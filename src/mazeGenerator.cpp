@@ -1,10 +1,18 @@
 #include "../include/mazeGenerator.hpp"
+#include <algorithm>
+#include <climits>
 
-MazeGenerator::MazeGenerator() : width(0), height(0), solving(false), solvingStep(0), explorationComplete(false) {
+MazeGenerator::MazeGenerator() : width(0), height(0), solving(false), solvingStep(0), explorationComplete(false), pathVersion(0), terrainEnabled(false), pathCost(0) {
     std::random_device rd;
     gen.seed(rd());
 }
 
+// Cells are carved on odd coordinates, so only odd sides leave the exit at
+// grid[height-1][width-2] connected to the rest of the maze.
+bool MazeGenerator::isValidSide(int side) {
+    return side >= minMazeSide && side <= maxMazeSide && side % 2 == 1;
+}
+
 void MazeGenerator::setSeed(unsigned int seed) {
     gen.seed(seed);
 }
@@ -22,6 +30,7 @@ void MazeGenerator::generate(int w, int h) {
     solving = false;
     solvingStep = 0;
     explorationComplete = false;
+    pathVersion++;
 
     grid = std::vector<std::vector<char>>(height, std::vector<char>(width, '#'));
 
@@ -67,6 +76,93 @@ void MazeGenerator::generate(int w, int h) {
 
     grid[0][1] = ' ';
     grid[height-1][width-2] = ' ';
+
+    if (terrainEnabled) {
+        openLoops();
+        generateTerrain();
+    } else {
+        costs.clear();
+    }
+}
+
+void MazeGenerator::openLoops() {
+    // A perfect maze has exactly one route, so costs could never change it.
+    // Knocking out some of the walls that separate two open cells adds
+    // alternative routes for the weighted solver to choose between.
+    for (int y = 1; y < height - 1; y++) {
+        for (int x = 1 + y % 2; x < width - 1; x += 2) {
+            if (grid[y][x] != '#') continue;
+
+            bool horizontal = grid[y][x - 1] == ' ' && grid[y][x + 1] == ' ';
+            bool vertical = grid[y - 1][x] == ' ' && grid[y + 1][x] == ' ';
+            if ((horizontal || vertical) && randomInt(1, loopChance) == 1) {
+                grid[y][x] = ' ';
+            }
+        }
+    }
+}
+
+void MazeGenerator::generateTerrain() {
+    // Value noise: random values on a coarse lattice, smoothly interpolated
+    // so that costs form patches of mud and water rather than static.
+    int latticeWidth = width / terrainScale + 2;
+    int latticeHeight = height / terrainScale + 2;
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    std::vector<float> lattice(latticeWidth * latticeHeight);
+    for (auto& value : lattice) {
+        value = dis(gen);
+    }
+
+    auto smooth = [](float t) { return t * t * (3.0f - 2.0f * t); };
+
+    costs.assign(width * height, 1);
+    for (int y = 0; y < height; y++) {
+        int ly = y / terrainScale;
+        float ty = smooth(static_cast<float>(y % terrainScale) / terrainScale);
+        const float* top = &lattice[ly * latticeWidth];
+        const float* bottom = &lattice[(ly + 1) * latticeWidth];
+
+        for (int x = 0; x < width; x++) {
+            int lx = x / terrainScale;
+            float tx = smooth(static_cast<float>(x % terrainScale) / terrainScale);
+            float upper = top[lx] + (top[lx + 1] - top[lx]) * tx;
+            float lower = bottom[lx] + (bottom[lx + 1] - bottom[lx]) * tx;
+            float noise = upper + (lower - upper) * ty;
+
+            int cost = 1 + static_cast<int>(noise * maxTerrainCost);
+            costs[y * width + x] = static_cast<unsigned char>(std::min(cost, maxTerrainCost));
+        }
+    }
+}
+
+void MazeGenerator::setTerrainEnabled(bool enabled) {
+    terrainEnabled = enabled;
+    if (!enabled) {
+        costs.clear();
+    } else if (width > 0 && height > 0) {
+        openLoops();
+        generateTerrain();
+    }
+
+    // Any previous solution was found against the old costs.
+    solving = false;
+    solvingStep = 0;
+    solutionPath.clear();
+    explorationPath.clear();
+    explorationComplete = false;
+    pathCost = 0;
+    pathVersion++;
+}
+
+bool MazeGenerator::hasTerrain() const {
+    return !costs.empty();
+}
+
+int MazeGenerator::getCost(int y, int x) const {
+    if (costs.empty() || y < 0 || y >= height || x < 0 || x >= width) {
+        return 1;
+    }
+    return costs[y * width + x];
 }
 
 void MazeGenerator::startSolving() {
@@ -77,8 +173,31 @@ void MazeGenerator::startSolving() {
     solutionPath.clear();
     explorationPath.clear();
     explorationComplete = false;
+    pathVersion++;
     lastStepTime = std::chrono::steady_clock::now();
 
+    bool found = hasTerrain() ? findWeightedPath() : findShortestPath();
+    if (!found) {
+        solving = false;
+    }
+}
+
+// Solves without animating: the paths are left fully revealed, as if
+// solveStep() had run to completion.
+bool MazeGenerator::solve(bool weighted) {
+    solving = false;
+    pathVersion++;
+
+    bool found = weighted ? findWeightedPath() : findShortestPath();
+    explorationComplete = true;
+    solvingStep = static_cast<int>(solutionPath.size());
+    return found;
+}
+
+bool MazeGenerator::findShortestPath() {
+    solutionPath.clear();
+    explorationPath.clear();
+
     std::vector<std::vector<bool>> visited(height, std::vector<bool>(width, false));
     std::vector<std::vector<std::pair<int, int>>> parent(height, std::vector<std::pair<int, int>>(width, {-1, -1}));
     std::queue<std::pair<int, int>> q;
@@ -117,6 +236,7 @@ void MazeGenerator::startSolving() {
         }
     }
 
+    pathCost = 0;
     if (found) {
         int py = targetY, px = targetX;
         std::vector<std::pair<int, int>> path;
@@ -132,9 +252,91 @@ void MazeGenerator::startSolving() {
         for (int i = path.size() - 1; i >= 0; i--) {
             solutionPath.push_back(path[i]);
         }
-    } else {
-        solving = false;
+        // Report the terrain cost of the route, as the weighted solver does.
+        for (size_t i = 1; i < solutionPath.size(); i++) {
+            pathCost += getCost(solutionPath[i].first, solutionPath[i].second);
+        }
     }
+
+    return found;
+}
+
+bool MazeGenerator::findWeightedPath() {
+    solutionPath.clear();
+    explorationPath.clear();
+    pathCost = 0;
+
+    int cellCount = width * height;
+    int start = 1;
+    int target = (height - 1) * width + (width - 2);
+
+    // Dial's algorithm: with integer costs in [1, maxTerrainCost] every
+    // tentative distance lies within maxTerrainCost of the current one, so a
+    // ring of maxTerrainCost + 1 buckets replaces the priority queue.
+    const int bucketCount = maxTerrainCost + 1;
+    std::vector<int> dist(cellCount, INT_MAX);
+    std::vector<int> parent(cellCount, -1);
+    std::vector<bool> settled(cellCount, false);
+    std::vector<std::vector<int>> buckets(bucketCount);
+    std::vector<int> current;
+    bool weighted = !costs.empty();
+
+    dist[start] = 0;
+    buckets[0].push_back(start);
+    long long pending = 1;
+
+    const int dy[4] = {-1, 0, 1, 0};
+    const int dx[4] = {0, 1, 0, -1};
+
+    bool found = false;
+    for (int d = 0; pending > 0 && !found; d++) {
+        current.swap(buckets[d % bucketCount]);
+        pending -= current.size();
+
+        for (int cell : current) {
+            if (settled[cell] || dist[cell] != d) continue;
+
+            int y = cell / width;
+            int x = cell % width;
+            settled[cell] = true;
+            explorationPath.push_back({y, x});
+
+            if (cell == target) {
+                found = true;
+                break;
+            }
+
+            for (int i = 0; i < 4; i++) {
+                int ny = y + dy[i];
+                int nx = x + dx[i];
+                if (ny < 0 || ny >= height || nx < 0 || nx >= width || grid[ny][nx] != ' ') continue;
+
+                int next = ny * width + nx;
+                if (settled[next]) continue;
+
+                int nd = d + (weighted ? costs[next] : 1);
+                if (nd < dist[next]) {
+                    dist[next] = nd;
+                    parent[next] = cell;
+                    buckets[nd % bucketCount].push_back(next);
+                    pending++;
+                }
+            }
+        }
+        current.clear();
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    for (int cell = target; cell != -1; cell = parent[cell]) {
+        solutionPath.push_back({cell / width, cell % width});
+    }
+    std::reverse(solutionPath.begin(), solutionPath.end());
+    pathCost = dist[target];
+
+    return true;
 }
 
 bool MazeGenerator::isSolving() const {
@@ -194,6 +396,14 @@ bool MazeGenerator::isExplorationComplete() const {
     return explorationComplete;
 }
 
+int MazeGenerator::getPathCost() const {
+    return pathCost;
+}
+
+int MazeGenerator::getPathVersion() const {
+    return pathVersion;
+}
+
 int MazeGenerator::getWidth() const {
     return width;
 }
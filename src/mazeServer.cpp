@@ -0,0 +1,693 @@
+#include "../include/mazeServer.hpp"
+#include "../include/mazeGenerator.hpp"
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
+MazeServer::MazeServer(const std::string& socketPath, size_t cacheLimit, const std::string& spillDir, size_t spillLimit)
+    : socketPath(socketPath), spillDir(spillDir), cacheLimit(cacheLimit), cacheSize(0), spillLimit(spillLimit),
+      spillSize(0), listenFd(-1), epollFd(-1), eventFd(-1), inFlightJobs(0), inFlightBytes(0), stopping(false) {
+}
+
+#ifdef __linux__
+
+static volatile sig_atomic_t serverRunning = 1;
+
+static void serverStopHandler(int) {
+    serverRunning = 0;
+}
+
+MazeServer::~MazeServer() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (auto& job : jobQueue) {
+        if (job.fd >= 0) close(job.fd);
+    }
+    for (auto& job : doneJobs) {
+        if (job.fd >= 0) close(job.fd);
+    }
+    for (auto& client : clients) {
+        for (auto& response : client.second.responses) {
+            if (response.fd >= 0) close(response.fd);
+        }
+        close(client.first);
+    }
+    for (auto& entry : cache) {
+        close(entry.second.fd);
+    }
+    for (auto& entry : spilling) {
+        close(entry.second.fd);
+    }
+    if (eventFd >= 0) close(eventFd);
+    if (epollFd >= 0) close(epollFd);
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+}
+
+bool MazeServer::parseRequest(const std::string& line, MazeRequest& request, std::string& error) const {
+    std::istringstream stream(line);
+    int solve = 0;
+    std::string extra;
+
+    if (!(stream >> request.algorithm >> request.width >> request.height >> request.seed >> solve) || (stream >> extra)) {
+        error = "expected: <algorithm> <width> <height> <seed> <solve>";
+        return false;
+    }
+    if (request.algorithm != "dfs") {
+        error = "unknown algorithm '" + request.algorithm + "'";
+        return false;
+    }
+    if (!MazeGenerator::isValidSide(request.width) || !MazeGenerator::isValidSide(request.height) ||
+        request.width > maxServedSide || request.height > maxServedSide) {
+        error = "width and height must be odd and between " + std::to_string(MazeGenerator::minMazeSide) +
+                " and " + std::to_string(maxServedSide);
+        return false;
+    }
+    if (solve != 0 && solve != 1) {
+        error = "solve must be 0 or 1";
+        return false;
+    }
+
+    request.solve = solve == 1;
+    return true;
+}
+
+std::string MazeServer::cacheKey(const MazeRequest& request) const {
+    return request.algorithm + "_" + std::to_string(request.width) + "_" + std::to_string(request.height) + "_" +
+           std::to_string(request.seed) + "_" + std::to_string(request.solve ? 1 : 0);
+}
+
+std::string MazeServer::spillPath(const std::string& key) const {
+    return spillDir + "/" + key + ".maze";
+}
+
+int MazeServer::lookup(const std::string& key, size_t& size) {
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+        size = it->second.size;
+        return dup(it->second.fd);
+    }
+
+    // Evicted but still being written out by a worker.
+    auto spillingIt = spilling.find(key);
+    if (spillingIt != spilling.end()) {
+        size = spillingIt->second.size;
+        return dup(spillingIt->second.fd);
+    }
+
+    auto spilledIt = spilled.find(key);
+    if (spilledIt == spilled.end()) return -1;
+
+    int fd = open(spillPath(key).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        spillSize -= spilledIt->second.size;
+        spillLru.erase(spilledIt->second.lruPosition);
+        spilled.erase(spilledIt);
+        return -1;
+    }
+
+    spillLru.splice(spillLru.begin(), spillLru, spilledIt->second.lruPosition);
+    size = spilledIt->second.size;
+    return fd;
+}
+
+void MazeServer::insert(const std::string& key, int fd, size_t size) {
+    lru.push_front(key);
+    cache[key] = {fd, size, lru.begin()};
+    cacheSize += size;
+}
+
+void MazeServer::evict() {
+    while (cacheSize > cacheLimit && !lru.empty()) {
+        std::string key = lru.back();
+        CacheEntry entry = cache[key];
+        cache.erase(key);
+        lru.pop_back();
+        cacheSize -= entry.size;
+
+        if (spillDir.empty() || spilled.count(key) || spilling.count(key)) {
+            close(entry.fd);
+            continue;
+        }
+
+        // The memfd stays servable from `spilling` until the worker has
+        // finished writing it out.
+        spilling[key] = entry;
+        pushJob({key, MazeRequest(), true, dup(entry.fd), entry.size, 0, false, ""});
+    }
+}
+
+void MazeServer::addSpilled(const std::string& key, size_t size) {
+    auto it = spilled.find(key);
+    if (it != spilled.end()) {
+        spillSize -= it->second.size;
+        spillLru.erase(it->second.lruPosition);
+    }
+
+    spillLru.push_front(key);
+    spilled[key] = {-1, size, spillLru.begin()};
+    spillSize += size;
+}
+
+void MazeServer::trimSpill() {
+    while (spillSize > spillLimit && !spillLru.empty()) {
+        const std::string& key = spillLru.back();
+        unlink(spillPath(key).c_str());
+        spillSize -= spilled[key].size;
+        spilled.erase(key);
+        spillLru.pop_back();
+    }
+}
+
+bool MazeServer::loadSpillDir() {
+    if (mkdir(spillDir.c_str(), 0755) < 0 && errno != EEXIST) {
+        std::cerr << "Cannot create spill directory " << spillDir << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Pick up files spilled by an earlier run so they count against the
+    // spill limit and can still be served.
+    DIR* dir = opendir(spillDir.c_str());
+    if (!dir) {
+        std::cerr << "Cannot open spill directory " << spillDir << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    const std::string suffix = ".maze";
+    while (dirent* item = readdir(dir)) {
+        std::string name = item->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            unlink((spillDir + "/" + name).c_str());
+            continue;
+        }
+        if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+
+        struct stat info;
+        if (stat((spillDir + "/" + name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+            addSpilled(name.substr(0, name.size() - suffix.size()), info.st_size);
+        }
+    }
+    closedir(dir);
+    trimSpill();
+    return true;
+}
+
+static bool renderMaze(unsigned int seed, int width, int height, bool solve, std::string& body) {
+    MazeGenerator maze;
+    maze.setSeed(seed);
+    maze.generate(width, height);
+
+    body.clear();
+    body.reserve(static_cast<size_t>(height) * (width + 1));
+    for (const auto& row : maze.getGrid()) {
+        body.append(row.begin(), row.end());
+        body.push_back('\n');
+    }
+
+    // Without terrain every step costs 1, so the weighted solver finds the
+    // same shortest path as BFS while keeping its state in flat arrays.
+    if (solve) {
+        if (!maze.solve(true)) return false;
+        for (const auto& cell : maze.getSolutionPath()) {
+            body[static_cast<size_t>(cell.first) * (width + 1) + cell.second] = '.';
+        }
+    }
+    return true;
+}
+
+static int writeMemfd(const std::string& name, const std::string& body) {
+    int fd = memfd_create(name.c_str(), MFD_CLOEXEC);
+    if (fd < 0) return -1;
+
+    size_t written = 0;
+    while (written < body.size()) {
+        ssize_t n = write(fd, body.data() + written, body.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return -1;
+        }
+        written += n;
+    }
+    return fd;
+}
+
+static bool writeSpillFile(const std::string& path, int fd, size_t size) {
+    // Write to a temporary name first so a reader never sees a partial file.
+    std::string tmpPath = path + ".tmp";
+    int out = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) return false;
+
+    off_t offset = 0;
+    while (static_cast<size_t>(offset) < size) {
+        if (sendfile(out, fd, &offset, size - offset) <= 0) break;
+    }
+    close(out);
+
+    if (static_cast<size_t>(offset) != size || rename(tmpPath.c_str(), path.c_str()) < 0) {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void MazeServer::workerLoop() {
+    while (true) {
+        Job job = {};
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this] { return stopping || !jobQueue.empty(); });
+            if (stopping) return;
+            job = std::move(jobQueue.front());
+            jobQueue.pop_front();
+        }
+
+        if (job.spill) {
+            job.ok = writeSpillFile(spillPath(job.key), job.fd, job.size);
+            close(job.fd);
+            job.fd = -1;
+        } else {
+            const MazeRequest& request = job.request;
+            std::string body;
+            if (!renderMaze(request.seed, request.width, request.height, request.solve, body)) {
+                job.error = "no solution found";
+            } else if ((job.fd = writeMemfd(job.key, body)) < 0) {
+                job.error = "generation failed";
+            } else {
+                job.size = body.size();
+                job.ok = true;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            doneJobs.push_back(std::move(job));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(eventFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void MazeServer::pushJob(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobQueue.push_back(std::move(job));
+    }
+    jobReady.notify_one();
+}
+
+void MazeServer::queueGeneration(const std::string& key, const MazeRequest& request) {
+    if (!queuedKeys.insert(key).second) return;
+
+    size_t cells = static_cast<size_t>(request.width) * request.height;
+    size_t cost = cells * (request.solve ? solveBytesPerCell : generateBytesPerCell);
+    waitingJobs.push_back({key, request, false, -1, 0, cost, false, ""});
+}
+
+void MazeServer::submitJobs() {
+    // One generation per worker at a time, and no more estimated memory in
+    // flight than the cache itself may hold. A job bigger than the whole
+    // budget still runs, but only on its own.
+    while (!waitingJobs.empty() && inFlightJobs < workers.size()) {
+        Job& job = waitingJobs.front();
+        if (inFlightJobs > 0 && inFlightBytes + job.cost > cacheLimit) break;
+
+        inFlightJobs++;
+        inFlightBytes += job.cost;
+        pushJob(std::move(job));
+        waitingJobs.pop_front();
+    }
+}
+
+void MazeServer::processCompletions() {
+    uint64_t count;
+    ssize_t ignored = read(eventFd, &count, sizeof(count));
+    (void)ignored;
+
+    std::vector<Job> finished;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        finished.swap(doneJobs);
+    }
+
+    for (auto& job : finished) {
+        if (job.spill) {
+            auto it = spilling.find(job.key);
+            if (it != spilling.end()) {
+                close(it->second.fd);
+                spilling.erase(it);
+            }
+            if (job.ok) addSpilled(job.key, job.size);
+            continue;
+        }
+
+        inFlightJobs--;
+        inFlightBytes -= job.cost;
+        queuedKeys.erase(job.key);
+
+        if (job.ok) {
+            insert(job.key, job.fd, job.size);
+        } else {
+            std::cerr << "Failed to generate " << job.key << ": " << job.error << std::endl;
+        }
+
+        auto waiting = waiters.find(job.key);
+        if (waiting != waiters.end()) {
+            for (Response* response : waiting->second) {
+                if (!resolve(*response)) {
+                    response->header = "ERR " + (job.ok ? std::string("generation failed") : job.error) + "\n";
+                }
+            }
+            waiters.erase(waiting);
+        }
+
+        evict();
+    }
+
+    trimSpill();
+    submitJobs();
+}
+
+bool MazeServer::resolve(Response& response) {
+    size_t size = 0;
+    int fd = lookup(response.key, size);
+    if (fd < 0) return false;
+
+    response.fd = fd;
+    response.size = size;
+    response.header = "OK " + std::to_string(size) + "\n";
+    return true;
+}
+
+void MazeServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        Client& client = clients[fd];
+        client.interest = EPOLLIN;
+        client.eof = false;
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+void MazeServer::parseLine(const std::string& line, Client& client) {
+    Response response = {"", "", 0, -1, 0, 0};
+    MazeRequest request;
+    std::string error;
+
+    if (!parseRequest(line, request, error)) {
+        response.header = "ERR " + error + "\n";
+    } else {
+        response.key = cacheKey(request);
+        if (!resolve(response)) {
+            queueGeneration(response.key, request);
+        }
+    }
+    client.responses.push_back(response);
+
+    if (client.responses.back().header.empty()) {
+        waiters[response.key].push_back(&client.responses.back());
+    }
+}
+
+bool MazeServer::parseInput(Client& client) {
+    size_t start = 0;
+    size_t end;
+    while (client.responses.size() < maxPipelined && (end = client.input.find('\n', start)) != std::string::npos) {
+        parseLine(client.input.substr(start, end - start), client);
+        start = end + 1;
+    }
+    client.input.erase(0, start);
+
+    end = client.input.find('\n');
+    if ((end == std::string::npos ? client.input.size() : end) > maxRequestLine) return false;
+
+    // Half-closed: a last request sent without a newline is still answered.
+    if (client.eof && !client.input.empty() && end == std::string::npos && client.responses.size() < maxPipelined) {
+        parseLine(client.input, client);
+        client.input.clear();
+    }
+    return true;
+}
+
+bool MazeServer::readClient(int fd, Client& client) {
+    char buffer[65536];
+    while (!client.eof && client.responses.size() < maxPipelined) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n == 0) {
+            // Half-closed: answer what was already asked, then close.
+            client.eof = true;
+            return parseInput(client);
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        client.input.append(buffer, n);
+        if (!parseInput(client)) return false;
+    }
+    return true;
+}
+
+bool MazeServer::flushClient(int fd, Client& client) {
+    while (!client.responses.empty()) {
+        Response& response = client.responses.front();
+        if (response.header.empty()) return true;
+
+        while (response.headerSent < response.header.size()) {
+            int flags = MSG_NOSIGNAL | (response.fd >= 0 ? MSG_MORE : 0);
+            ssize_t n = send(fd, response.header.data() + response.headerSent,
+                             response.header.size() - response.headerSent, flags);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            response.headerSent += n;
+        }
+
+        // The maze body goes straight from the memfd or spill file to the
+        // socket without passing through user space.
+        while (response.fd >= 0 && static_cast<size_t>(response.offset) < response.size) {
+            ssize_t n = sendfile(fd, response.fd, &response.offset, response.size - response.offset);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            if (n == 0) return false;
+        }
+
+        if (response.fd >= 0) close(response.fd);
+        client.responses.pop_front();
+    }
+    return true;
+}
+
+void MazeServer::updateInterest(int fd, Client& client) {
+    unsigned int interest = 0;
+    if (!client.eof && client.responses.size() < maxPipelined) interest |= EPOLLIN;
+    if (!client.responses.empty() && !client.responses.front().header.empty()) interest |= EPOLLOUT;
+
+    if (interest != client.interest) {
+        client.interest = interest;
+
+        epoll_event event = {};
+        event.events = interest;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+    }
+}
+
+void MazeServer::closeClient(int fd) {
+    auto it = clients.find(fd);
+    if (it == clients.end()) return;
+
+    for (auto& response : it->second.responses) {
+        if (response.fd >= 0) close(response.fd);
+        if (!response.header.empty()) continue;
+
+        auto waiting = waiters.find(response.key);
+        if (waiting == waiters.end()) continue;
+        auto& list = waiting->second;
+        list.erase(std::remove(list.begin(), list.end(), &response), list.end());
+        if (list.empty()) waiters.erase(waiting);
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    clients.erase(it);
+}
+
+int MazeServer::run() {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << socketPath << std::endl;
+        return 1;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    if (!spillDir.empty() && !loadSpillDir()) {
+        return 1;
+    }
+
+    // Only replace a socket left behind by a server that is gone; a live one
+    // still accepts connections.
+    struct stat info;
+    if (lstat(socketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0) {
+            std::cerr << "Cannot create socket: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        bool stale = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 && errno == ECONNREFUSED;
+        close(probe);
+        if (!stale) {
+            std::cerr << "Socket " << socketPath << " is already in use" << std::endl;
+            return 1;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 ||
+        bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listenFd, SOMAXCONN) < 0) {
+        std::cerr << "Cannot listen on " << socketPath << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) < 0) {
+        std::cerr << "Cannot set up epoll: " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, serverStopHandler);
+    signal(SIGTERM, serverStopHandler);
+
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    event.data.fd = eventFd;
+    if (eventFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, eventFd, &event) < 0) {
+        std::cerr << "Cannot set up eventfd: " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    unsigned int workerCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&MazeServer::workerLoop, this);
+    }
+
+    std::cout << "Serving mazes on " << socketPath << std::endl;
+
+    const int maxEvents = 256;
+    epoll_event events[maxEvents];
+    std::vector<int> closing;
+
+    while (serverRunning) {
+        int count = epoll_wait(epollFd, events, maxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            return 1;
+        }
+
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+            if (fd == eventFd) {
+                processCompletions();
+                continue;
+            }
+
+            auto it = clients.find(fd);
+            if (it == clients.end()) continue;
+
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                closing.push_back(fd);
+            } else if ((events[i].events & EPOLLIN) && !readClient(fd, it->second)) {
+                closing.push_back(fd);
+            }
+        }
+
+        for (int fd : closing) {
+            closeClient(fd);
+        }
+        closing.clear();
+
+        // Sending frees pipeline slots, so requests held back in the input
+        // buffer are parsed and then flushed in case they were cache hits.
+        for (auto& client : clients) {
+            Client& state = client.second;
+            if (!flushClient(client.first, state) || !parseInput(state) || !flushClient(client.first, state) ||
+                (state.eof && state.responses.empty() && state.input.empty())) {
+                closing.push_back(client.first);
+            } else {
+                updateInterest(client.first, state);
+            }
+        }
+
+        for (int fd : closing) {
+            closeClient(fd);
+        }
+        closing.clear();
+
+        submitJobs();
+    }
+
+    std::cout << "Goodbye!" << std::endl;
+    return 0;
+}
+
+#else
+
+MazeServer::~MazeServer() {
+}
+
+int MazeServer::run() {
+    std::cerr << "Server mode is only supported on Linux" << std::endl;
+    return 1;
+}
+
+#endif
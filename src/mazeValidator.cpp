@@ -0,0 +1,144 @@
+#include "../include/mazeValidator.hpp"
+#include <algorithm>
+#include <thread>
+
+// Rows per block below which splitting the grid across more threads costs
+// more than it saves.
+static const int minRowsPerBlock = 64;
+
+MazeValidator::MazeValidator() : width(0), height(0), openCells(0), edgeCount(0), mergeCount(0), endpointsOpen(false) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void MazeValidator::setThreadCount(int count) {
+    threadCount = std::max(1, count);
+}
+
+int MazeValidator::findRoot(int cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+bool MazeValidator::unite(int a, int b) {
+    int rootA = findRoot(a);
+    int rootB = findRoot(b);
+    if (rootA == rootB) return false;
+
+    if (rootA < rootB) {
+        parent[rootB] = rootA;
+    } else {
+        parent[rootA] = rootB;
+    }
+    return true;
+}
+
+void MazeValidator::validateBlock(const std::vector<std::vector<char>>& grid, int firstRow, int lastRow,
+                                  long long& open, long long& edges, long long& merges) {
+    // Every cell and edge touched here lies inside [firstRow, lastRow), so
+    // blocks can be processed concurrently on the shared parent array.
+    for (int y = firstRow; y < lastRow; y++) {
+        const std::vector<char>& row = grid[y];
+        for (int x = 0; x < width; x++) {
+            if (row[x] != ' ') continue;
+
+            int cell = y * width + x;
+            open++;
+
+            if (x + 1 < width && row[x + 1] == ' ') {
+                edges++;
+                if (unite(cell, cell + 1)) merges++;
+            }
+            if (y + 1 < lastRow && grid[y + 1][x] == ' ') {
+                edges++;
+                if (unite(cell, cell + width)) merges++;
+            }
+        }
+    }
+}
+
+bool MazeValidator::validate(const MazeGenerator& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    openCells = 0;
+    edgeCount = 0;
+    mergeCount = 0;
+    endpointsOpen = false;
+
+    if (width < 2 || height < 2) {
+        return false;
+    }
+
+    const auto& grid = maze.getGrid();
+    endpointsOpen = grid[0][1] == ' ' && grid[height - 1][width - 2] == ' ';
+
+    parent.resize(static_cast<size_t>(width) * height);
+    for (int i = 0; i < static_cast<int>(parent.size()); i++) {
+        parent[i] = i;
+    }
+
+    int blocks = std::max(1, std::min(threadCount, height / minRowsPerBlock));
+    std::vector<int> blockStart(blocks + 1);
+    for (int i = 0; i <= blocks; i++) {
+        blockStart[i] = static_cast<int>(static_cast<long long>(height) * i / blocks);
+    }
+
+    std::vector<long long> open(blocks, 0);
+    std::vector<long long> edges(blocks, 0);
+    std::vector<long long> merges(blocks, 0);
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < blocks; i++) {
+        workers.emplace_back(&MazeValidator::validateBlock, this, std::cref(grid), blockStart[i], blockStart[i + 1],
+                             std::ref(open[i]), std::ref(edges[i]), std::ref(merges[i]));
+    }
+    validateBlock(grid, blockStart[0], blockStart[1], open[0], edges[0], merges[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (int i = 0; i < blocks; i++) {
+        openCells += open[i];
+        edgeCount += edges[i];
+        mergeCount += merges[i];
+    }
+
+    // Stitch the blocks together along the vertical edges crossing each seam.
+    for (int i = 1; i < blocks; i++) {
+        int y = blockStart[i] - 1;
+        for (int x = 0; x < width; x++) {
+            if (grid[y][x] == ' ' && grid[y + 1][x] == ' ') {
+                edgeCount++;
+                if (unite(y * width + x, (y + 1) * width + x)) mergeCount++;
+            }
+        }
+    }
+
+    return isPerfect();
+}
+
+bool MazeValidator::isPerfect() const {
+    return endpointsOpen && openCells > 0 && getComponentCount() == 1 && edgeCount == openCells - 1;
+}
+
+bool MazeValidator::hasCycle() const {
+    return edgeCount > mergeCount;
+}
+
+bool MazeValidator::areEndpointsOpen() const {
+    return endpointsOpen;
+}
+
+long long MazeValidator::getOpenCells() const {
+    return openCells;
+}
+
+long long MazeValidator::getEdgeCount() const {
+    return edgeCount;
+}
+
+long long MazeValidator::getComponentCount() const {
+    return openCells - mergeCount;
+}